@@ -24,5 +24,9 @@
 #define PERSIST_STATE 1
 #define PERSIST_LAPS 4
 
+// Number of lap layers on the main window, and laps kept in the history window.
+#define LAP_TIME_SIZE 5
+#define MAX_LAPS 30
+
 void format_lap(double lap_time, char* buffer);
 double float_time_ms();
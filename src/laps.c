@@ -25,12 +25,12 @@
 
 #include "laps.h"
 #include "common.h"
+#include "ui_budget.h"
 
 static Window* window; 
 static ScrollLayer* scroll_view;
 static TextLayer* no_laps_note;
 
-#define MAX_LAPS 30
 #define LAP_STRING_LENGTH 15
 
 static TextLayer* lap_layers[MAX_LAPS];
@@ -45,23 +45,27 @@ static GFont laps_font;
 
 void handle_appear(Window *window);
 
-void init_lap_window() {
-	window = window_create();
+bool init_lap_window() {
+	window = ui_budget_claim(UiWindow, window_create());
+	if(window == NULL) return false;
     window_set_background_color(window, GColorWhite);
     window_set_window_handlers(window, (WindowHandlers){
         .appear = (WindowHandler)handle_appear
     });
 
-	scroll_view = scroll_layer_create(GRect(0, 0, 144, 152));
+	scroll_view = ui_budget_claim(UiScrollLayer, scroll_layer_create(GRect(0, 0, 144, 152)));
+	if(scroll_view == NULL) return false;
     scroll_layer_set_click_config_onto_window(scroll_view, window);
 
-    laps_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_DEJAVU_SANS_SUBSET_18));
+    laps_font = ui_budget_claim(UiFont, fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_DEJAVU_SANS_SUBSET_18)));
+	if(laps_font == NULL) return false;
 
     for(int i = 0; i < MAX_LAPS; ++i) {
         memcpy(lap_text[i], " 1) 12:34:56.7", LAP_STRING_LENGTH);
 		lap_times[i] = 0.0;
 
-		lap_layers[i] = text_layer_create(GRect(0, i * 22, 144, 22));
+		lap_layers[i] = ui_budget_claim(UiTextLayer, text_layer_create(GRect(0, i * 22, 144, 22)));
+		if(lap_layers[i] == NULL) return false;
         text_layer_set_background_color(lap_layers[i], GColorClear);
         text_layer_set_font(lap_layers[i], laps_font);
         text_layer_set_text_color(lap_layers[i], GColorBlack);
@@ -73,23 +77,15 @@ void init_lap_window() {
     layer_add_child(window_get_root_layer(window), (Layer*)scroll_view);
 
     // Add a prompt for more laps.
-	no_laps_note = text_layer_create(GRect(0, 61, 144, 30));
+	no_laps_note = ui_budget_claim(UiTextLayer, text_layer_create(GRect(0, 61, 144, 30)));
+	if(no_laps_note == NULL) return false;
     text_layer_set_background_color(no_laps_note, GColorClear);
     text_layer_set_font(no_laps_note, laps_font);
     text_layer_set_text_color(no_laps_note, GColorBlack);
     text_layer_set_text_alignment(no_laps_note, GTextAlignmentCenter);
     text_layer_set_text(no_laps_note, "No laps yet.");
     layer_add_child(window_get_root_layer(window), (Layer*)no_laps_note);
-}
-
-void deinit_lap_window() {
-	text_layer_destroy(no_laps_note);
-	for(int i = 0; i < MAX_LAPS; ++i) {
-		text_layer_destroy(lap_layers[i]);
-	}
-	fonts_unload_custom_font(laps_font);
-	scroll_layer_destroy(scroll_view);
-	window_destroy(window);
+	return true;
 }
 
 void show_laps() {
@@ -21,11 +21,10 @@
  */
 
 
-void init_lap_window();
+bool init_lap_window();
 void show_laps();
 void store_lap_time(double t);
 void clear_stored_laps();
-void deinit_lap_window();
 
 typedef void (*LapRestoredCallback)(double time);
 status_t persist_laps();
@@ -24,6 +24,7 @@
 
 #include "laps.h"
 #include "common.h"
+#include "ui_budget.h"
 
 static Window* window;
 
@@ -36,9 +37,9 @@ static BitmapLayer* button_labels;
 
 
 // Lap time display
-#define LAP_TIME_SIZE 5
 static char lap_times[LAP_TIME_SIZE][11] = {"00:00:00.0", "00:01:00.0", "00:02:00.0", "00:03:00.0", "00:04:00.0"};
 static TextLayer* lap_layers[LAP_TIME_SIZE]; // an extra temporary layer
+static PropertyAnimation* lap_animations[LAP_TIME_SIZE]; // one per layer, reused
 static int next_lap_layer = 0;
 static int lap_time_count = 0;
 static double last_lap_time = 0;
@@ -78,7 +79,7 @@ struct StopwatchState {
 
 void toggle_stopwatch_handler(ClickRecognizerRef recognizer, Window *window);
 void config_provider(Window *window);
-void handle_init();
+bool handle_init();
 time_t time_seconds();
 void stop_stopwatch();
 void start_stopwatch();
@@ -90,12 +91,17 @@ int main();
 void draw_line(Layer *me, GContext* ctx);
 void save_lap_time(double seconds, bool animate);
 void lap_time_handler(ClickRecognizerRef recognizer, Window *window);
-void shift_lap_layer(PropertyAnimation** animation, Layer* layer, GRect* target, int distance_multiplier);
+void shift_lap_layer(int index, int distance_multiplier, bool animate);
+void run_lap_animation(int index, GRect from, GRect to, AnimationCurve curve, uint32_t delay);
+void animation_stopped(Animation *animation, void *data);
 void lap_restored(double time);
 
-void handle_init() {
-	window = window_create();
-    window_stack_push(window, true /* Animated */);
+bool handle_init() {
+	// Note how much heap we start with, so we can see what the UI costs.
+	ui_budget_init();
+
+	window = ui_budget_claim(UiWindow, window_create());
+	if(window == NULL) return false;
     window_set_background_color(window, GColorBlack);
     window_set_fullscreen(window, false);
 
@@ -103,15 +109,17 @@ void handle_init() {
     window_set_click_config_provider(window, (ClickConfigProvider) config_provider);
 
     // Get our fonts
-    big_font = fonts_load_custom_font(resource_get_handle(FONT_BIG_TIME));
-    seconds_font = fonts_load_custom_font(resource_get_handle(FONT_SECONDS));
-    laps_font = fonts_load_custom_font(resource_get_handle(FONT_LAPS));
+    big_font = ui_budget_claim(UiFont, fonts_load_custom_font(resource_get_handle(FONT_BIG_TIME)));
+    seconds_font = ui_budget_claim(UiFont, fonts_load_custom_font(resource_get_handle(FONT_SECONDS)));
+    laps_font = ui_budget_claim(UiFont, fonts_load_custom_font(resource_get_handle(FONT_LAPS)));
+	if(big_font == NULL || seconds_font == NULL || laps_font == NULL) return false;
 
     // Root layer
     Layer *root_layer = window_get_root_layer(window);
 
     // Set up the big timer.
-	big_time_layer = text_layer_create(GRect(0, 5, 96, 35));
+	big_time_layer = ui_budget_claim(UiTextLayer, text_layer_create(GRect(0, 5, 96, 35)));
+	if(big_time_layer == NULL) return false;
     text_layer_set_background_color(big_time_layer, GColorBlack);
     text_layer_set_font(big_time_layer, big_font);
     text_layer_set_text_color(big_time_layer, GColorWhite);
@@ -119,7 +127,8 @@ void handle_init() {
     text_layer_set_text_alignment(big_time_layer, GTextAlignmentRight);
     layer_add_child(root_layer, (Layer*)big_time_layer);
 
-    seconds_time_layer = text_layer_create(GRect(96, 17, 49, 35));
+    seconds_time_layer = ui_budget_claim(UiTextLayer, text_layer_create(GRect(96, 17, 49, 35)));
+	if(seconds_time_layer == NULL) return false;
     text_layer_set_background_color(seconds_time_layer, GColorBlack);
     text_layer_set_font(seconds_time_layer, seconds_font);
     text_layer_set_text_color(seconds_time_layer, GColorWhite);
@@ -127,29 +136,46 @@ void handle_init() {
     layer_add_child(root_layer, (Layer*)seconds_time_layer);
 
     // Draw our nice line.
-    line_layer = layer_create(GRect(0, 45, 144, 2));
+    line_layer = ui_budget_claim(UiLayer, layer_create(GRect(0, 45, 144, 2)));
+	if(line_layer == NULL) return false;
 	layer_set_update_proc(line_layer, draw_line);
     layer_add_child(root_layer, line_layer);
 
     // Set up the lap time layers. These will be made visible later.
     for(int i = 0; i < LAP_TIME_SIZE; ++i) {
-		lap_layers[i] = text_layer_create(GRect(-139, 52, 139, 30));
+		lap_layers[i] = ui_budget_claim(UiTextLayer, text_layer_create(GRect(-139, 52, 139, 30)));
+		if(lap_layers[i] == NULL) return false;
         text_layer_set_background_color(lap_layers[i], GColorClear);
         text_layer_set_font(lap_layers[i], laps_font);
         text_layer_set_text_color(lap_layers[i], GColorWhite);
         text_layer_set_text(lap_layers[i], lap_times[i]);
         layer_add_child(root_layer, (Layer*)lap_layers[i]);
+
+		// Its animation lives as long as it does; run_lap_animation() retargets it.
+		GRect frame = layer_get_frame((Layer*)lap_layers[i]);
+		lap_animations[i] = ui_budget_claim(UiAnimation, property_animation_create_layer_frame((Layer*)lap_layers[i], &frame, &frame));
+		if(lap_animations[i] == NULL) return false;
+		animation_set_duration((Animation*)lap_animations[i], 250);
+		animation_set_handlers((Animation*)lap_animations[i], (AnimationHandlers){
+			.stopped = (AnimationStoppedHandler)animation_stopped
+		}, NULL);
     }
 
     // Add some button labels
 	
-	button_bitmap = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_BUTTON_LABELS);
-	button_labels = bitmap_layer_create(GRect(130, 10, 14, 136));
+	button_bitmap = ui_budget_claim(UiBitmap, gbitmap_create_with_resource(RESOURCE_ID_IMAGE_BUTTON_LABELS));
+	button_labels = ui_budget_claim(UiBitmapLayer, bitmap_layer_create(GRect(130, 10, 14, 136)));
+	if(button_bitmap == NULL || button_labels == NULL) return false;
 	bitmap_layer_set_bitmap(button_labels, button_bitmap);
     layer_add_child(root_layer, (Layer*)button_labels);
 
     // Set up lap time stuff, too.
-    init_lap_window();
+    if(!init_lap_window()) return false;
+
+	// Only show anything once we know all of it exists.
+	if(!ui_budget_ready()) return false;
+	ui_budget_report();
+    window_stack_push(window, true /* Animated */);
 	
 	struct StopwatchState state;
 	if(persist_read_data(PERSIST_STATE, &state, sizeof(state)) != E_DOES_NOT_EXIST) {
@@ -166,6 +192,7 @@ void handle_init() {
 		APP_LOG(APP_LOG_LEVEL_DEBUG, "Loaded persisted state.");
 	}
 	restore_laps((LapRestoredCallback)lap_restored);
+	return true;
 }
 
 void lap_restored(double time) {
@@ -188,20 +215,8 @@ void handle_deinit() {
 	if(status < S_SUCCESS) {
 		APP_LOG(APP_LOG_LEVEL_WARNING, "Failed to persist laps: %ld", status);
 	}
-	deinit_lap_window();
-	
-	bitmap_layer_destroy(button_labels);
-	gbitmap_destroy(button_bitmap);
-	for(int i = 0; i < LAP_TIME_SIZE; ++i) {
-		text_layer_destroy(lap_layers[i]);
-	}
-	layer_destroy(line_layer);
-	text_layer_destroy(seconds_time_layer);
-	text_layer_destroy(big_time_layer);
-	fonts_unload_custom_font(big_font);
-	fonts_unload_custom_font(seconds_font);
-	fonts_unload_custom_font(laps_font);
-	window_destroy(window);
+	// Everything we created, both windows included, newest first.
+	ui_budget_destroy_all();
 }
 
 void draw_line(Layer *me, GContext* ctx) {
@@ -250,11 +265,8 @@ void reset_stopwatch_handler(ClickRecognizerRef recognizer, Window *window) {
 
     // Animate all the laps away.
     busy_animating = LAP_TIME_SIZE;
-    static PropertyAnimation* animations[LAP_TIME_SIZE];
-    static GRect targets[LAP_TIME_SIZE];
     for(int i = 0; i < LAP_TIME_SIZE; ++i) {
-        shift_lap_layer(&animations[i], (Layer*)lap_layers[i], &targets[i], LAP_TIME_SIZE);
-        animation_schedule((Animation*)animations[i]);
+        shift_lap_layer(i, LAP_TIME_SIZE, true);
     }
     next_lap_layer = 0;
     clear_stored_laps();
@@ -299,61 +311,50 @@ void update_stopwatch() {
 }
 
 void animation_stopped(Animation *animation, void *data) {
-	property_animation_destroy((PropertyAnimation*)animation);
     --busy_animating;
 }
 
-void shift_lap_layer(PropertyAnimation** animation, Layer* layer, GRect* target, int distance_multiplier) {
+// The lap animations are never destroyed while we run, so point this layer's
+// one at the new frames and schedule it again.
+void run_lap_animation(int index, GRect from, GRect to, AnimationCurve curve, uint32_t delay) {
+	PropertyAnimation* animation = lap_animations[index];
+	animation->values.from.grect = from;
+	animation->values.to.grect = to;
+	animation_set_curve((Animation*)animation, curve);
+	animation_set_delay((Animation*)animation, delay);
+	animation_schedule((Animation*)animation);
+}
+
+void shift_lap_layer(int index, int distance_multiplier, bool animate) {
+    Layer* layer = (Layer*)lap_layers[index];
     GRect origin = layer_get_frame(layer);
-    *target = origin;
-    target->origin.y += target->size.h * distance_multiplier;
-	if(animation != NULL) {
-		*animation = property_animation_create_layer_frame(layer, NULL, target);
-		animation_set_duration((Animation*)*animation, 250);
-		animation_set_curve((Animation*)*animation, AnimationCurveLinear);
-		animation_set_handlers((Animation*)*animation, (AnimationHandlers){
-			.stopped = (AnimationStoppedHandler)animation_stopped
-		}, NULL);
+    GRect target = origin;
+    target.origin.y += target.size.h * distance_multiplier;
+	if(animate) {
+		run_lap_animation(index, origin, target, AnimationCurveLinear, 0);
 	} else {
-		layer_set_frame(layer, *target);
+		layer_set_frame(layer, target);
 	}
 }
 
 void save_lap_time(double lap_time, bool animate) {
     if(busy_animating && animate) return;
 
-    static PropertyAnimation* animations[LAP_TIME_SIZE];
-    static GRect targets[LAP_TIME_SIZE];
-
     // Shift them down visually (assuming they actually exist)
 	if(animate) {
 		busy_animating = LAP_TIME_SIZE;
-		for(int i = 0; i < LAP_TIME_SIZE; ++i) {
-			if(i == next_lap_layer) continue; // This is handled separately.
-			shift_lap_layer(&animations[i], (Layer*)lap_layers[i], &targets[i], 1);
-			animation_schedule((Animation*)animations[i]);
-		}
-	} else {
-		for(int i = 0; i < LAP_TIME_SIZE; ++i) {
-			if(i == next_lap_layer) continue; // This is handled separately.
-			shift_lap_layer(NULL, (Layer*)lap_layers[i], &targets[i], 1);
-		}
+	}
+	for(int i = 0; i < LAP_TIME_SIZE; ++i) {
+		if(i == next_lap_layer) continue; // This is handled separately.
+		shift_lap_layer(i, 1, animate);
 	}
 
     // Once those are done we can slide our new lap time in.
     format_lap(lap_time, lap_times[next_lap_layer]);
 
     // Animate it
-    static PropertyAnimation* entry_animation;
-	
 	if(animate) {
-		entry_animation = property_animation_create_layer_frame((Layer*)lap_layers[next_lap_layer], &GRect(-139, 52, 139, 26), &GRect(5, 52, 139, 26));
-		animation_set_curve((Animation*)entry_animation, AnimationCurveEaseOut);
-		animation_set_delay((Animation*)entry_animation, 50);
-		animation_set_handlers((Animation*)entry_animation, (AnimationHandlers){
-			.stopped = (AnimationStoppedHandler)animation_stopped
-		}, NULL);
-		animation_schedule((Animation*)entry_animation);
+		run_lap_animation(next_lap_layer, GRect(-139, 52, 139, 26), GRect(5, 52, 139, 26), AnimationCurveEaseOut, 50);
 	} else {
 		layer_set_frame((Layer*)lap_layers[next_lap_layer], GRect(5, 52, 139, 26));
 	}
@@ -384,7 +385,11 @@ void config_provider(Window *window) {
 }
 
 int main() {
-	handle_init();
+	if(!handle_init()) {
+		APP_LOG(APP_LOG_LEVEL_ERROR, "Couldn't set up the UI; giving up.");
+		ui_budget_destroy_all();
+		return 1;
+	}
 	app_event_loop();
 	handle_deinit();
 	return 0;
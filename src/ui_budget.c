@@ -0,0 +1,111 @@
+/*
+ * Pebble Stopwatch - UI object budget
+ * Copyright (C) 2013 Katharine Berry
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <pebble.h>
+
+#include "common.h"
+#include "ui_budget.h"
+
+#define UI_BUDGET_STR_(x) #x
+#define UI_BUDGET_STR(x) UI_BUDGET_STR_(x)
+#pragma message("UI budget: " UI_BUDGET_STR(UI_BUDGET_OBJECTS_TOTAL) " objects, " UI_BUDGET_STR(UI_BUDGET_BYTES_TOTAL) " bytes")
+
+static struct {
+	UiObjectKind kind;
+	void* object;
+} objects[UI_BUDGET_OBJECTS];
+static int object_count = 0;
+static bool failed = false;
+static size_t heap_at_init = 0;
+
+// Only a warning: the per-object costs are estimates, so running short here
+// doesn't mean startup will fail. A create that does fail is caught by
+// ui_budget_claim().
+void ui_budget_init() {
+	size_t free_bytes = heap_bytes_free();
+	heap_at_init = heap_bytes_used();
+	APP_LOG(APP_LOG_LEVEL_DEBUG, "UI budget is %d bytes; %d free.", UI_BUDGET_BYTES, (int)free_bytes);
+	if(free_bytes < UI_BUDGET_BYTES) {
+		APP_LOG(APP_LOG_LEVEL_WARNING, "Less heap free than the UI budget expects.");
+	}
+}
+
+static void destroy_object(UiObjectKind kind, void* object) {
+	switch(kind) {
+		case UiWindow: window_destroy(object); break;
+		case UiTextLayer: text_layer_destroy(object); break;
+		case UiLayer: layer_destroy(object); break;
+		case UiScrollLayer: scroll_layer_destroy(object); break;
+		case UiBitmapLayer: bitmap_layer_destroy(object); break;
+		case UiBitmap: gbitmap_destroy(object); break;
+		case UiFont: fonts_unload_custom_font(object); break;
+		case UiAnimation: property_animation_destroy(object); break;
+	}
+}
+
+// Records an object created during startup and hands it back. A NULL object,
+// or one more than we budgeted for, fails startup and returns NULL; callers
+// must check for that before using the result.
+void* ui_budget_claim(UiObjectKind kind, void* object) {
+	if(object == NULL) {
+		APP_LOG(APP_LOG_LEVEL_ERROR, "UI budget: allocation %d failed.", object_count);
+		failed = true;
+		return NULL;
+	}
+	if(object_count >= UI_BUDGET_OBJECTS) {
+		APP_LOG(APP_LOG_LEVEL_ERROR, "UI budget: more than %d objects claimed.", UI_BUDGET_OBJECTS);
+		destroy_object(kind, object);
+		failed = true;
+		return NULL;
+	}
+	objects[object_count].kind = kind;
+	objects[object_count].object = object;
+	++object_count;
+	return object;
+}
+
+bool ui_budget_ready() {
+	if(!failed && object_count != UI_BUDGET_OBJECTS) {
+		APP_LOG(APP_LOG_LEVEL_ERROR, "UI budget: %d objects claimed, %d budgeted.", object_count, UI_BUDGET_OBJECTS);
+		failed = true;
+	}
+	return !failed;
+}
+
+void ui_budget_report() {
+	int used = (int)(heap_bytes_used() - heap_at_init);
+	APP_LOG(APP_LOG_LEVEL_DEBUG, "UI budget %d bytes; startup used %d.", UI_BUDGET_BYTES, used);
+	if(used > UI_BUDGET_BYTES) {
+		APP_LOG(APP_LOG_LEVEL_WARNING, "UI budget is %d bytes short; update UI_BUDGET_COST_*.", used - UI_BUDGET_BYTES);
+	}
+}
+
+// Destroys everything claimed so far, newest first, so children go before
+// the layers and windows they were added to, and fonts and bitmaps outlive
+// the layers that use them.
+void ui_budget_destroy_all() {
+	while(object_count > 0) {
+		--object_count;
+		destroy_object(objects[object_count].kind, objects[object_count].object);
+	}
+}
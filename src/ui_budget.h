@@ -0,0 +1,91 @@
+/*
+ * Pebble Stopwatch - UI object budget public header
+ * Copyright (C) 2013 Katharine Berry
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+// UI objects come from the normal app heap; the SDK creates them and we can't
+// place them ourselves. This only keeps a list of what was created, checks
+// the count against the numbers below, and destroys everything in one go.
+
+#include "common.h"
+
+// Every UI object the app ever holds. Each one has to go through
+// ui_budget_claim(), and ui_budget_ready() fails unless exactly
+// UI_BUDGET_OBJECTS were claimed, so a new layer needs counting here as well.
+#define UI_BUDGET_WINDOWS 2
+#define UI_BUDGET_TEXT_LAYERS (2 + LAP_TIME_SIZE + MAX_LAPS + 1)
+#define UI_BUDGET_LAYERS 1
+#define UI_BUDGET_SCROLL_LAYERS 1
+#define UI_BUDGET_BITMAP_LAYERS 1
+#define UI_BUDGET_BITMAPS 1
+#define UI_BUDGET_FONTS 4
+// One animation per main window lap layer, created once and reused.
+#define UI_BUDGET_ANIMATIONS LAP_TIME_SIZE
+#define UI_BUDGET_OBJECTS (UI_BUDGET_WINDOWS + UI_BUDGET_TEXT_LAYERS + UI_BUDGET_LAYERS + \
+                           UI_BUDGET_SCROLL_LAYERS + UI_BUDGET_BITMAP_LAYERS + UI_BUDGET_BITMAPS + \
+                           UI_BUDGET_FONTS + UI_BUDGET_ANIMATIONS)
+
+// Heap cost of each object, including allocator overhead. These are upper
+// estimates, not measurements, so nothing refuses to start over them;
+// ui_budget_report() logs what handle_init really used next to
+// UI_BUDGET_BYTES, so correct them from that log.
+#define UI_BUDGET_COST_WINDOW 128
+#define UI_BUDGET_COST_TEXT_LAYER 80
+#define UI_BUDGET_COST_LAYER 48
+#define UI_BUDGET_COST_SCROLL_LAYER 224
+#define UI_BUDGET_COST_BITMAP_LAYER 64
+#define UI_BUDGET_COST_BITMAP (16 + 4 * 136) // 14x136 button labels, word-aligned rows
+#define UI_BUDGET_COST_FONT 96
+#define UI_BUDGET_COST_ANIMATION 80
+
+#define UI_BUDGET_BYTES (UI_BUDGET_WINDOWS * UI_BUDGET_COST_WINDOW + \
+                         UI_BUDGET_TEXT_LAYERS * UI_BUDGET_COST_TEXT_LAYER + \
+                         UI_BUDGET_LAYERS * UI_BUDGET_COST_LAYER + \
+                         UI_BUDGET_SCROLL_LAYERS * UI_BUDGET_COST_SCROLL_LAYER + \
+                         UI_BUDGET_BITMAP_LAYERS * UI_BUDGET_COST_BITMAP_LAYER + \
+                         UI_BUDGET_BITMAPS * UI_BUDGET_COST_BITMAP + \
+                         UI_BUDGET_FONTS * UI_BUDGET_COST_FONT + \
+                         UI_BUDGET_ANIMATIONS * UI_BUDGET_COST_ANIMATION)
+
+// The same totals written out, so the build can print them. If you change
+// anything above, the asserts below tell you what these need to become.
+#define UI_BUDGET_OBJECTS_TOTAL 53
+#define UI_BUDGET_BYTES_TOTAL 4976
+
+_Static_assert(UI_BUDGET_OBJECTS == UI_BUDGET_OBJECTS_TOTAL, "UI_BUDGET_OBJECTS_TOTAL is out of date");
+_Static_assert(UI_BUDGET_BYTES == UI_BUDGET_BYTES_TOTAL, "UI_BUDGET_BYTES_TOTAL is out of date");
+
+typedef enum {
+	UiWindow,
+	UiTextLayer,
+	UiLayer,
+	UiScrollLayer,
+	UiBitmapLayer,
+	UiBitmap,
+	UiFont,
+	UiAnimation
+} UiObjectKind;
+
+void ui_budget_init();
+void* ui_budget_claim(UiObjectKind kind, void* object);
+bool ui_budget_ready();
+void ui_budget_report();
+void ui_budget_destroy_all();